@@ -0,0 +1,71 @@
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <vector>
+#include <utility>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+// 합성 temporal graph 생성기
+// edge 순서가 곧 시간 순서 : snapshot k는 앞쪽 (k+1)*batch_size개의 edge
+// block마다 seed를 고정하므로 thread 수와 무관하게 같은 graph가 생성됨
+template <typename Node>
+class generator{
+    typedef std::pair<Node,Node> Edge;
+    static const int64_t block_size = 1<<18;
+
+    int scale_;
+    int64_t num_nodes_;
+    int64_t num_edges_;
+    bool uniform_;
+    uint64_t seed_;
+
+    // RMAT(Kronecker) : a=0.57, b=0.19, c=0.19
+    Edge rmat_edge(std::mt19937_64 &rng, std::uniform_real_distribution<float> &dist){
+        const float a = 0.57f, b = 0.19f, c = 0.19f;
+        Node u = 0, v = 0;
+        for(int depth=0; depth<scale_; ++depth){
+            float p = dist(rng);
+            u <<= 1; v <<= 1;
+            if(p < a) continue;
+            else if(p < a+b) v |= 1;
+            else if(p < a+b+c) u |= 1;
+            else u |= 1, v |= 1;
+        }
+        return {u,v};
+    }
+
+public:
+    generator(int scale, int64_t num_edges, bool uniform, uint64_t seed) :
+        scale_(scale), num_nodes_(int64_t(1)<<scale), num_edges_(num_edges),
+        uniform_(uniform), seed_(seed){}
+
+    std::vector<Edge> generate(){
+        std::vector<Edge> el(num_edges_);
+        int64_t num_block = (num_edges_ + block_size - 1) / block_size;
+        #pragma omp parallel for
+        for(int64_t block=0; block<num_block; ++block){
+            std::mt19937_64 rng(seed_ * 1000003 + block);
+            std::uniform_int_distribution<Node> udist(0, num_nodes_-1);
+            std::uniform_real_distribution<float> rdist(0, 1);
+            int64_t end = std::min((block+1)*block_size, num_edges_);
+            for(int64_t e=block*block_size; e<end; ++e)
+                el[e] = uniform_ ? Edge(udist(rng), udist(rng)) : rmat_edge(rng, rdist);
+        }
+        return el;
+    }
+
+    // snapshot별 delta batch로 분할
+    static std::vector<std::vector<Edge>> split(std::vector<Edge> &el, int num_sn, int64_t batch_size){
+        std::vector<std::vector<Edge>> batches(num_sn);
+        for(int i=0;i<num_sn;++i){
+            int64_t begin = std::min<int64_t>(el.size(), batch_size*i);
+            int64_t end = std::min<int64_t>(el.size(), batch_size*(i+1));
+            batches[i].assign(el.begin()+begin, el.begin()+end);
+        }
+        return batches;
+    }
+};
+
+#endif
@@ -0,0 +1,342 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unistd.h>
+#include <omp.h>
+
+#include "../chronos/csrgraph.h"
+#include "../chronos/chronos.h"
+#include "../common/timer.h"
+#include "../chronos/partition.h"
+#include "../common/numa_alloc.h"
+#include "../llama/graph_manager.h"
+#include "../llama/snapshot_export.h"
+#include "generator.h"
+
+using namespace std;
+
+typedef int Node;
+typedef pair<Node,Node> Edge;
+
+const float df = 0.85;
+
+struct config{
+    bool uniform = false;
+    int scale = 14;
+    int edge_factor = 16;
+    int num_sn = 6;
+    int64_t batch_size = 0;
+    int num_iter = 20;
+    int num_trials = 3;
+    uint64_t seed = 27491095;
+    bool json = false;
+    numa_mode numa = numa_parse_mode(getenv("GRAPH_NUMA"));
+};
+
+struct measurement{
+    string system, phase;
+    vector<double> seconds;
+};
+
+vector<measurement> results;
+
+void record(const string &system, const string &phase, double sec){
+    for(auto &m: results){
+        if(m.system == system && m.phase == phase){
+            m.seconds.push_back(sec);
+            return;
+        }
+    }
+    results.push_back({system, phase, {sec}});
+}
+
+void usage(char *name){
+    printf("usage: %s [-g rmat|uniform] [-s scale] [-e edge factor] [-n snapshots]\n"
+           "          [-b batch size] [-i pagerank iterations] [-t trials] [-r seed]\n"
+           "          [-m off|first_touch|interleave] [-j]\n", name);
+}
+
+// ===== baseline : snapshot마다 독립된 CSRGraph =====
+
+int64_t csr_scan(CSRGraph<Node> *g, int num_sn, vector<edge_partition> &out_part){
+    int64_t checksum = 0;
+    for(int s=0;s<num_sn;++s){
+        edge_partition &part = out_part[s];
+        #pragma omp parallel for reduction(+:checksum) schedule(dynamic, 1)
+        for(int p=0;p<part.num_parts();++p)
+            for(Node n=part.begin(p);n<part.end(p);++n)
+                for(const auto &v: g[s].out_neigh(n)) checksum += v;
+    }
+    return checksum;
+}
+
+void csr_pagerank(CSRGraph<Node> &g, const edge_partition &part, int num_iter){
+    int64_t num_nodes = g.num_nodes();
+    const datatype base_score = (1.0f - df) / num_nodes;
+    vector<datatype> score(num_nodes, 1.0f / num_nodes), contrib(num_nodes);
+    for(int iter=0;iter<num_iter;++iter){
+        #pragma omp parallel for
+        for(Node n=0;n<num_nodes;++n)
+            contrib[n] = score[n] / g.out_degree(n);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(int p=0;p<part.num_parts();++p){
+            for(Node v=part.begin(p);v<part.end(p);++v){
+                if(part.is_hub(g.in_degree(v))) continue;
+                datatype incoming_total = 0;
+                for(const auto &u: g.in_neigh(v)) incoming_total += contrib[u];
+                score[v] = base_score + df*incoming_total;
+            }
+        }
+
+        for(auto v: part.hubs()){
+            datatype incoming_total = 0;
+            Node *neigh = g.in_index(v);
+            #pragma omp parallel for reduction(+:incoming_total)
+            for(int64_t i=0;i<g.in_degree(v);++i) incoming_total += contrib[neigh[i]];
+            score[v] = base_score + df*incoming_total;
+        }
+    }
+}
+
+// ===== LLAMA =====
+
+int64_t llama_scan(graph_manager<Node> &manager){
+    int64_t checksum = 0;
+    for(size_t s=0;s<manager.num_snapshots();++s){
+        #pragma omp parallel for reduction(+:checksum) schedule(dynamic, 64)
+        for(Node n=0;n<manager.num_nodes(s);++n)
+            manager.out_neigh(s, n, [&checksum](Node v){ checksum += v;});
+    }
+    return checksum;
+}
+
+// LLAMA는 out-edge만 저장하므로 push 방식
+void llama_pagerank(graph_manager<Node> &manager, size_t snap_id, int num_iter){
+    int64_t num_nodes = manager.num_nodes(snap_id);
+    const datatype base_score = (1.0f - df) / num_nodes;
+    vector<datatype> score(num_nodes, 1.0f / num_nodes), incoming_total(num_nodes);
+    vector<int64_t> out_degree(num_nodes);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(Node n=0;n<num_nodes;++n) out_degree[n] = manager.out_degree(snap_id, n);
+
+    for(int iter=0;iter<num_iter;++iter){
+        fill(incoming_total.begin(), incoming_total.end(), 0);
+        #pragma omp parallel for schedule(dynamic, 64)
+        for(Node u=0;u<num_nodes;++u){
+            if(out_degree[u] == 0) continue;
+            datatype contrib = score[u] / out_degree[u];
+            manager.out_neigh(snap_id, u, [&](Node v){
+                #pragma omp atomic
+                incoming_total[v] += contrib;
+            });
+        }
+
+        #pragma omp parallel for
+        for(Node n=0;n<num_nodes;++n)
+            score[n] = base_score + df*incoming_total[n];
+    }
+}
+
+// ===== Chronos =====
+
+int64_t chronos_scan(chronos_graph &cg){
+    int64_t checksum = 0;
+    #pragma omp parallel for reduction(+:checksum) schedule(dynamic, 64)
+    for(int n=0;n<cg.max_v;++n)
+        for(auto edge: cg.edge_array_out[n])
+            for(int s=0;s<cg.num_sn;++s)
+                if(edge.is_set(s)) checksum += edge.target;
+    return checksum;
+}
+
+void run_trial(config &conf, vector<vector<Edge>> &batches){
+    Timer t;
+    int num_sn = conf.num_sn;
+
+    // baseline
+    double csr_build = 0;
+    CSRGraph<Node> *g = new CSRGraph<Node>[num_sn];
+    vector<Edge> el;
+    for(int i=0;i<num_sn;++i){
+        el.insert(el.end(), batches[i].begin(), batches[i].end());
+        t.Start();
+        g[i] = CSRGraph<Node>(el);
+        t.Stop();
+        csr_build += t.Seconds();
+    }
+    vector<Edge>().swap(el);
+    record("csr", "ingest", csr_build);
+
+    // scan/pagerank 시간에 partition 생성이 섞이지 않도록 따로 측정
+    vector<edge_partition> out_part, in_part;
+    t.Start();
+    for(int s=0;s<num_sn;++s){
+        out_part.emplace_back(g[s].num_nodes(), [&](int64_t n){ return g[s].out_degree(n);}, false);
+        in_part.emplace_back(g[s].num_nodes(), [&](int64_t n){ return g[s].in_degree(n);});
+    }
+    t.Stop();
+    record("csr", "partition", t.Seconds());
+
+    int64_t last_num_edges = g[num_sn-1].num_edges();
+    int64_t csr_checksum;
+    TIME_OP(t, csr_checksum = csr_scan(g, num_sn, out_part));
+    record("csr", "scan", t.Seconds());
+
+    t.Start();
+    for(int s=0;s<num_sn;++s) csr_pagerank(g[s], in_part[s], conf.num_iter);
+    t.Stop();
+    record("csr", "pagerank", t.Seconds());
+
+    // Chronos : baseline의 CSRGraph로부터 edge array 구성 (CSR 생성 시간은 csr ingest와 같음)
+    {
+        chronos_graph cg(g, num_sn);
+        t.Start();
+        cg.make_vertex_array();
+        cg.make_edge_array(g);
+        t.Stop();
+        record("chronos", "snapshot", t.Seconds());
+        record("chronos", "ingest", csr_build + t.Seconds());
+
+        TIME_OP(t, chronos_scan(cg));
+        record("chronos", "scan", t.Seconds());
+
+        TIME_OP(t, cg.pagerank(conf.num_iter, 0, df, false));
+        record("chronos", "pagerank", t.Seconds());
+    }
+    delete[] g;
+
+    // LLAMA
+    {
+        graph_manager<Node> manager(false);
+        Timer t_snap;
+        t.Start();
+        manager.init_graph(batches[0]);
+        t_snap.Start();
+        for(int i=1;i<num_sn;++i) manager.add_snapshot(batches[i]);
+        t_snap.Stop();
+        t.Stop();
+        record("llama", "ingest", t.Seconds());
+        record("llama", "csr_build", manager.csr_build_seconds());
+        record("llama", "snapshot", t_snap.Seconds());
+
+        int64_t llama_checksum;
+        TIME_OP(t, llama_checksum = llama_scan(manager));
+        record("llama", "scan", t.Seconds());
+        if(llama_checksum != csr_checksum)
+            fprintf(stderr, "warning: llama scan checksum %ld != csr %ld\n", llama_checksum, csr_checksum);
+
+        t.Start();
+        for(int s=0;s<num_sn;++s) llama_pagerank(manager, s, conf.num_iter);
+        t.Stop();
+        record("llama", "pagerank", t.Seconds());
+
+        // 마지막 snapshot을 CSRGraph로, 전체 범위를 Chronos edge array로 export
+        t.Start();
+        CSRGraph<Node> flat = flatten_snapshot(manager.view(num_sn-1));
+        t.Stop();
+        record("llama", "flatten", t.Seconds());
+        if(flat.num_edges() != last_num_edges)
+            fprintf(stderr, "warning: flattened snapshot has %ld edges, csr %ld\n", flat.num_edges(), last_num_edges);
+
+        // flatten과 같이 결과를 scope 끝까지 유지해 해제 시간이 측정에 섞이지 않게 함
+        t.Start();
+        chronos_graph exported = export_chronos(manager.view(num_sn-1), 0);
+        t.Stop();
+        record("llama", "export_chronos", t.Seconds());
+    }
+}
+
+void print_results(config &conf, int64_t num_edges){
+    const char *gen = conf.uniform ? "uniform" : "rmat";
+    int threads = omp_get_max_threads();
+    const char *numa = numa_mode_name(conf.numa);
+    if(conf.json){
+        printf("{\"generator\": \"%s\", \"scale\": %d, \"edges\": %ld, \"snapshots\": %d, "
+               "\"batch_size\": %ld, \"threads\": %d, \"numa\": \"%s\", \"seed\": %lu, \"results\": [",
+               gen, conf.scale, num_edges, conf.num_sn, conf.batch_size, threads, numa, conf.seed);
+    }else{
+        printf("generator,scale,edges,snapshots,batch_size,threads,numa,system,phase,trials,mean,stddev,min,max\n");
+    }
+
+    for(size_t i=0;i<results.size();++i){
+        vector<double> &sec = results[i].seconds;
+        double mean = 0, var = 0;
+        for(double x: sec) mean += x;
+        mean /= sec.size();
+        for(double x: sec) var += (x-mean)*(x-mean);
+        double stddev = sec.size() > 1 ? sqrt(var / (sec.size()-1)) : 0;
+        double mn = *min_element(sec.begin(), sec.end());
+        double mx = *max_element(sec.begin(), sec.end());
+        if(conf.json){
+            printf("%s\n  {\"system\": \"%s\", \"phase\": \"%s\", \"trials\": %zu, \"mean\": %lf, "
+                   "\"stddev\": %lf, \"min\": %lf, \"max\": %lf, \"seconds\": [",
+                   i ? "," : "", results[i].system.c_str(), results[i].phase.c_str(),
+                   sec.size(), mean, stddev, mn, mx);
+            for(size_t j=0;j<sec.size();++j) printf("%s%lf", j ? ", " : "", sec[j]);
+            printf("]}");
+        }else{
+            printf("%s,%d,%ld,%d,%ld,%d,%s,%s,%s,%zu,%lf,%lf,%lf,%lf\n",
+                   gen, conf.scale, num_edges, conf.num_sn, conf.batch_size, threads, numa,
+                   results[i].system.c_str(), results[i].phase.c_str(),
+                   sec.size(), mean, stddev, mn, mx);
+        }
+    }
+    if(conf.json) printf("\n]}\n");
+}
+
+int main(int argc, char **argv){
+    INSTRUMENT_INIT();
+    // command line parsing
+    config conf;
+    int opt;
+    while((opt = getopt(argc, argv, "g:s:e:n:b:i:t:r:m:jh")) != -1){
+        switch(opt){
+            case 'g':
+                if(string(optarg) != "rmat" && string(optarg) != "uniform"){ usage(argv[0]); return 0;}
+                conf.uniform = string(optarg) == "uniform";
+                break;
+            case 's': conf.scale = atoi(optarg); break;
+            case 'e': conf.edge_factor = atoi(optarg); break;
+            case 'n': conf.num_sn = atoi(optarg); break;
+            case 'b': conf.batch_size = atol(optarg); break;
+            case 'i': conf.num_iter = atoi(optarg); break;
+            case 't': conf.num_trials = atoi(optarg); break;
+            case 'r': conf.seed = strtoull(optarg, nullptr, 10); break;
+            case 'm':
+                // 모르는 이름은 numa_parse_mode가 off로 바꾸므로 여기서 거름
+                conf.numa = numa_parse_mode(optarg);
+                if(string(optarg) != numa_mode_name(conf.numa)){ usage(argv[0]); return 0;}
+                break;
+            case 'j': conf.json = true; break;
+            default: usage(argv[0]); return 0;
+        }
+    }
+    // Chronos bitmap은 int32
+    if(conf.num_sn < 1 || conf.num_sn > 32 || conf.scale < 1 || conf.scale > 30 || conf.num_trials < 1){
+        usage(argv[0]);
+        return 0;
+    }
+
+    numa_init(conf.numa);
+
+    int64_t num_edges = (int64_t(1)<<conf.scale) * conf.edge_factor;
+    if(conf.batch_size > 0) num_edges = conf.batch_size * conf.num_sn;
+    else conf.batch_size = (num_edges + conf.num_sn - 1) / conf.num_sn;
+
+    generator<Node> gen(conf.scale, num_edges, conf.uniform, conf.seed);
+    vector<Edge> el = gen.generate();
+    vector<vector<Edge>> batches = generator<Node>::split(el, conf.num_sn, conf.batch_size);
+    vector<Edge>().swap(el);
+
+    for(int trial=0;trial<conf.num_trials;++trial)
+        run_trial(conf, batches);
+
+    print_results(conf, num_edges);
+    INSTRUMENT_REPORT(stderr);
+}
@@ -0,0 +1,110 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <omp.h>
+
+#include "../common/timer.h"
+#include "../common/numa_alloc.h"
+
+using namespace std;
+
+// NUMA bandwidth 측정
+// 1) cpu node x memory node : 한 node의 thread들이 다른 node에 bind된 array를 읽음
+// 2) 전체 thread로 array를 읽을 때 할당 모드(off/first_touch/interleave) 비교
+
+struct stat_t{ double mean, stddev; };
+
+stat_t summarize(vector<double> &gbps){
+    double mean = 0, var = 0;
+    for(double x: gbps) mean += x;
+    mean /= gbps.size();
+    for(double x: gbps) var += (x-mean)*(x-mean);
+    return {mean, gbps.size() > 1 ? sqrt(var / (gbps.size()-1)) : 0};
+}
+
+// 병렬 읽기, GB/s
+double read_bandwidth(int64_t *arr, int64_t n, int num_threads){
+    Timer t;
+    int64_t sum = 0;
+    t.Start();
+    #pragma omp parallel for schedule(static) reduction(+:sum) num_threads(num_threads)
+    for(int64_t i=0;i<n;++i) sum += arr[i];
+    t.Stop();
+    if(sum == -1) printf("#");
+    return n*sizeof(int64_t) / t.Seconds() / 1e9;
+}
+
+int main(int argc, char **argv){
+    int64_t size_mb = 1024;
+    int num_trials = 5;
+    int opt;
+    while((opt = getopt(argc, argv, "s:t:h")) != -1){
+        switch(opt){
+            case 's': size_mb = atol(optarg); break;
+            case 't': num_trials = atoi(optarg); break;
+            default: printf("usage: %s [-s size(MB)] [-t trials]\n", argv[0]); return 0;
+        }
+    }
+    int64_t n = size_mb * (1<<20) / sizeof(int64_t);
+    vector<int> nodes = numa_nodes();
+
+    printf("test,cpu_node,mem_node,mode,threads,size_mb,trials,gbps_mean,gbps_stddev\n");
+
+    // 1) local / remote
+    for(int cpu_node: nodes){
+        vector<int> cpus = numa_node_cpus(cpu_node);
+        if(cpus.empty()) continue;
+        int num_threads = cpus.size();
+        #pragma omp parallel num_threads(num_threads)
+        numa_pin_thread(cpus[omp_get_thread_num()]);
+
+        for(int mem_node: nodes){
+            int64_t *arr = numa_alloc<int64_t>(n);
+            unsigned long mask = numa_node_mask(vector<int>(1, mem_node));
+            syscall(__NR_mbind, arr, n*sizeof(int64_t), MPOL_BIND, &mask, sizeof(mask)*8, MPOL_MF_MOVE);
+            #pragma omp parallel for schedule(static) num_threads(num_threads)
+            for(int64_t i=0;i<n;++i) arr[i] = i;
+
+            vector<double> gbps;
+            for(int trial=0;trial<num_trials;++trial) gbps.push_back(read_bandwidth(arr, n, num_threads));
+            stat_t st = summarize(gbps);
+            printf("%s,%d,%d,bind,%d,%ld,%d,%lf,%lf\n", cpu_node == mem_node ? "local" : "remote",
+                   cpu_node, mem_node, num_threads, size_mb, num_trials, st.mean, st.stddev);
+            numa_free(arr, n);
+        }
+    }
+
+    // 2) 할당 모드 비교 : off는 master thread가 초기화
+    cpu_set_t all;
+    CPU_ZERO(&all);
+    for(int node: nodes) for(int c: numa_node_cpus(node)) CPU_SET(c, &all);
+    vector<int> cpus;
+    for(int c=0;c<CPU_SETSIZE;++c) if(CPU_ISSET(c, &all)) cpus.push_back(c);
+    if(cpus.empty()) return 0;
+    int num_threads = cpus.size();
+    #pragma omp parallel num_threads(num_threads)
+    numa_pin_thread(cpus[omp_get_thread_num()]);
+
+    numa_mode modes[3] = {NUMA_OFF, NUMA_FIRST_TOUCH, NUMA_INTERLEAVE};
+    for(numa_mode mode: modes){
+        numa_policy() = mode;
+        int64_t *arr = numa_alloc<int64_t>(n);
+        if(mode == NUMA_OFF){
+            for(int64_t i=0;i<n;++i) arr[i] = i;
+        }else{
+            #pragma omp parallel for schedule(static) num_threads(num_threads)
+            for(int64_t i=0;i<n;++i) arr[i] = i;
+        }
+
+        vector<double> gbps;
+        for(int trial=0;trial<num_trials;++trial) gbps.push_back(read_bandwidth(arr, n, num_threads));
+        stat_t st = summarize(gbps);
+        printf("alloc,-1,-1,%s,%d,%ld,%d,%lf,%lf\n", numa_mode_name(mode),
+               num_threads, size_mb, num_trials, st.mean, st.stddev);
+        numa_free(arr, n);
+    }
+}
@@ -0,0 +1,284 @@
+#ifndef CHRONOS_H_
+#define CHRONOS_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+#include "csrgraph.h"
+#include "../common/instrument.h"
+#include "partition.h"
+
+typedef float datatype;
+
+struct edge{
+    int target;
+    int32_t bitmap;
+    edge(int t):target(t),bitmap(0){}
+    edge(int t, int num):edge(t){
+        bit_on(num);
+    }
+    void bit_on(int num){
+        // bitmap |= (1<<(31-num)); //논문표현
+        bitmap |= 1<<num; //프린트 편의상
+    }
+
+    bool is_set(int num){
+        return (bitmap & (1<<num)) != 0;
+    }
+
+    void print_edge(int num_snapshot = 32){
+        printf("target: %d\tbitmap: ", target);
+        for(int i=0;i<num_snapshot;++i) printf("%d",(bitmap>>i)&1);
+        printf("\n");
+    }
+
+    bool operator==(const edge &other) const{ return target == other.target;}
+    bool operator!=(const edge &other) const{ return !(*this == other);}
+};
+
+// in memory design : 한 vertex의 모든 snapshot 값을 연속으로 저장
+class chronos_graph{
+public:
+    int num_sn;
+    int max_v;
+    std::vector<int64_t> num_nodes;
+    std::vector<std::vector<datatype>> vertex_array_cur, vertex_array_update;
+    std::vector<std::vector<edge>> edge_array_in, edge_array_out;
+
+    chronos_graph(CSRGraph<int> *g, int n_sn) : num_sn(n_sn), max_v(0), num_nodes(n_sn){
+        for(int i=0;i<num_sn;++i){
+            num_nodes[i] = g[i].num_nodes();
+            if(max_v < num_nodes[i]) max_v = num_nodes[i];
+        }
+        vertex_array_cur.resize(max_v);
+        vertex_array_update.resize(max_v);
+        edge_array_in.resize(max_v);
+        edge_array_out.resize(max_v);
+    }
+
+    // snapshot별 vertex 수만으로 생성, edge array는 호출하는 쪽에서 채움 (LLAMA export)
+    chronos_graph(const std::vector<int64_t> &n) : num_sn(n.size()), max_v(0), num_nodes(n){
+        for(int i=0;i<num_sn;++i)
+            if(max_v < num_nodes[i]) max_v = num_nodes[i];
+        vertex_array_cur.resize(max_v);
+        vertex_array_update.resize(max_v);
+        edge_array_in.resize(max_v);
+        edge_array_out.resize(max_v);
+    }
+
+    void make_vertex_array(){
+        PHASE("chronos.vertex_array");
+        #pragma omp parallel for
+        for(int i=0;i<max_v;++i) {
+            vertex_array_cur[i].resize(num_sn);
+            vertex_array_update[i].resize(num_sn);
+        }
+        COUNT_BYTES("chronos.vertex_array", 2*int64_t(max_v)*num_sn*sizeof(datatype));
+    }
+
+    // edge bitmap array가 차지하는 byte
+    size_t edge_array_bytes(){
+        size_t bytes = 0;
+        for(int i=0;i<max_v;++i)
+            bytes += (edge_array_in[i].capacity() + edge_array_out[i].capacity())*sizeof(edge);
+        return bytes;
+    }
+
+    // edge array는 vertex마다 target 순으로 정렬된 상태를 유지
+    // snapshot i의 neighbor를 정렬/중복제거 후 기존 array와 merge
+    static void merge_neighbors(std::vector<edge> &arr, int *begin, int *end, int i, std::vector<int> &buf){
+        buf.assign(begin, end);
+        std::sort(buf.begin(), buf.end());
+        buf.erase(std::unique(buf.begin(), buf.end()), buf.end());
+
+        std::vector<edge> merged;
+        merged.reserve(arr.size() + buf.size());
+        size_t a = 0, b = 0;
+        while(a < arr.size() || b < buf.size()){
+            if(b == buf.size() || (a < arr.size() && arr[a].target < buf[b])) merged.push_back(arr[a++]);
+            else if(a == arr.size() || buf[b] < arr[a].target) merged.push_back(edge(buf[b++], i));
+            else{
+                merged.push_back(arr[a++]);
+                merged.back().bit_on(i);
+                ++b;
+            }
+        }
+        arr.swap(merged);
+    }
+
+    void make_edge_array(CSRGraph<int> *g){
+        PHASE("chronos.edge_array");
+        for(int i=0;i<num_sn;++i){
+            // vertex 하나의 edge array는 한 thread만 수정하므로 hub도 나누지 않음
+            edge_partition part(g[i].num_nodes(),
+                [&](int64_t v){ return g[i].in_degree(v) + g[i].out_degree(v);}, false);
+            #pragma omp parallel
+            {
+                std::vector<int> buf;
+                #pragma omp for schedule(dynamic, 1)
+                for(int p=0;p<part.num_parts();++p){
+                    for(int j=part.begin(p);j<part.end(p);++j){
+                        merge_neighbors(edge_array_in[j], g[i].in_index(j), g[i].in_index(j+1), i, buf);
+                        merge_neighbors(edge_array_out[j], g[i].out_index(j), g[i].out_index(j+1), i, buf);
+                    }
+                }
+            }
+        }
+        COUNT_BYTES("chronos.edge_array", edge_array_bytes());
+    }
+
+    // ===== query =====
+    // 모두 out-edge 기준, edge_array_out[u]에서 binary search
+
+    edge* find_edge(int u, int v){
+        if(u < 0 || u >= max_v) return nullptr;
+        std::vector<edge> &arr = edge_array_out[u];
+        auto it = std::lower_bound(arr.begin(), arr.end(), v,
+            [](const edge &e, int t){ return e.target < t;});
+        if(it == arr.end() || it->target != v) return nullptr;
+        return &*it;
+    }
+
+    // u->v edge가 존재한 snapshot들의 bitmap (없으면 0)
+    int32_t edge_lifetime(int u, int v){
+        edge *e = find_edge(u, v);
+        return e == nullptr ? 0 : e->bitmap;
+    }
+
+    bool has_edge(int u, int v, int s){
+        if(s < 0 || s >= num_sn) return false;
+        edge *e = find_edge(u, v);
+        return e != nullptr && e->is_set(s);
+    }
+
+    std::vector<int> neighbors(int u, int s){
+        std::vector<int> neigh;
+        if(u < 0 || u >= max_v || s < 0 || s >= num_sn) return neigh;
+        for(auto &e: edge_array_out[u])
+            if(e.is_set(s)) neigh.push_back(e.target);
+        return neigh;
+    }
+
+    // snapshot별 out-degree
+    std::vector<int> degree_over_time(int u){
+        std::vector<int> degree(num_sn, 0);
+        if(u < 0 || u >= max_v) return degree;
+        for(auto &e: edge_array_out[u])
+            for(int s=0;s<num_sn;++s)
+                if(e.is_set(s)) ++degree[s];
+        return degree;
+    }
+
+    // batch query : query를 thread들에 나눠 처리
+    void edge_lifetime(const std::vector<std::pair<int,int>> &queries, std::vector<int32_t> &lifetimes){
+        lifetimes.resize(queries.size());
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for(size_t i=0;i<queries.size();++i)
+            lifetimes[i] = edge_lifetime(queries[i].first, queries[i].second);
+    }
+
+    void has_edge(const std::vector<std::pair<int,int>> &queries, int s, std::vector<char> &result){
+        result.resize(queries.size());
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for(size_t i=0;i<queries.size();++i)
+            result[i] = has_edge(queries[i].first, queries[i].second, s);
+    }
+
+    // pagerank example
+    void pagerank(int max_iter, double epsilon, float df = 0.85, bool verbose = true){
+        PHASE("chronos.pagerank");
+        std::vector<datatype> init_score(num_sn), base_score(num_sn);
+        for(int i=0;i<num_sn;++i)
+            init_score[i] = 1.0f / num_nodes[i], base_score[i] = (1.0f - df) / num_nodes[i];
+
+        std::vector<std::vector<int>> out_degree(max_v);
+        std::vector<std::vector<datatype>> out_contrib(max_v);
+        #pragma omp parallel for
+        for(int i=0;i<max_v;++i) out_degree[i].resize(num_sn,0), out_contrib[i].resize(num_sn);
+
+        #pragma omp parallel for
+        for(int n=0;n<max_v;++n){
+            for(auto edge: edge_array_out[n]){
+                for(int s=0;s<num_sn;++s){
+                    if(edge.is_set(s)) ++out_degree[n][s];
+                }
+            }
+        }
+
+        #pragma omp parallel for
+        for(int n=0;n<max_v;++n){
+            for(int s=0;s<num_sn;++s){
+                vertex_array_cur[n][s] = init_score[s];
+            }
+        }
+
+        edge_partition part(max_v, [this](int64_t v){ return (int64_t)edge_array_in[v].size();});
+
+        for(int iter = 0;iter<max_iter;++iter){
+            PHASE("chronos.pagerank.iteration");
+            std::vector<double> errors(num_sn,0);
+            double *err = errors.data();
+            #pragma omp parallel for
+            for(int v=0;v<max_v;++v)
+                for(int s=0;s<num_sn;++s)
+                    out_contrib[v][s] = vertex_array_cur[v][s]/out_degree[v][s];
+
+            auto update = [&](int v, datatype *incoming_totals, double *local_errors){
+                for(int s=0;s<num_sn;++s){
+                    if(v < num_nodes[s]){
+                        vertex_array_update[v][s] = base_score[s] + df*incoming_totals[s];
+                        local_errors[s] += fabs(vertex_array_update[v][s] - vertex_array_cur[v][s]);
+                    }
+                }
+            };
+
+            #pragma omp parallel reduction(+:err[:num_sn])
+            {
+                std::vector<datatype> incoming_totals(num_sn);
+                #pragma omp for schedule(dynamic, 1)
+                for(int p=0;p<part.num_parts();++p){
+                    for(int v=part.begin(p);v<part.end(p);++v){
+                        if(part.is_hub(edge_array_in[v].size())) continue;
+                        std::fill(incoming_totals.begin(), incoming_totals.end(), 0);
+                        for(auto edge: edge_array_in[v]){
+                            int u = edge.target;
+                            for(int s = 0;s<num_sn;++s){
+                                if(edge.is_set(s))
+                                    incoming_totals[s] += out_contrib[u][s];
+                            }
+                        }
+                        update(v, incoming_totals.data(), err);
+                    }
+                }
+            }
+
+            // hub vertex는 in-edge를 thread들에 나눠 합산
+            for(auto v: part.hubs()){
+                std::vector<datatype> incoming_totals(num_sn,0);
+                datatype *totals = incoming_totals.data();
+                #pragma omp parallel for reduction(+:totals[:num_sn])
+                for(size_t i=0;i<edge_array_in[v].size();++i){
+                    edge &e = edge_array_in[v][i];
+                    for(int s = 0;s<num_sn;++s){
+                        if(e.is_set(s))
+                            totals[s] += out_contrib[e.target][s];
+                    }
+                }
+                update(v, totals, err);
+            }
+            if(verbose){
+                std::cout<<iter<<std::endl;
+                for(int s=0;s<num_sn;++s) printf("snapshot %d: %lf\n",s,errors[s]);
+            }
+            if(errors[num_sn-1] < epsilon) break;
+
+            vertex_array_cur.swap(vertex_array_update);
+        }
+    }
+};
+
+#endif
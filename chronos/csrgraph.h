@@ -7,6 +7,9 @@
 #include <cstdio>
 #include <iostream>
 
+#include "../common/instrument.h"
+#include "../common/numa_alloc.h"
+
 typedef int64_t Offset;
 
 template <typename Node>
@@ -48,6 +51,7 @@ public:
     }
 
     Node* count_degree(std::vector<Edge> &el, bool inv){
+        PHASE("csr.degree_count");
         Node* degree = new Node[num_nodes_];
         #pragma omp parallel for
         for(int i=0;i<num_nodes_;++i) degree[i] = 0;
@@ -61,6 +65,7 @@ public:
     }
 
     Offset* count_offset(Node* degree){
+        PHASE("csr.prefix_sum");
         int64_t block_size = 1<<20;
         int64_t num_block = (num_nodes_ + (block_size-1))/block_size;
 
@@ -82,7 +87,7 @@ public:
         #pragma omp parallel for
         for(int i=0;i<num_block;++i){
             int end = std::min((i+1)*block_size, num_nodes_);
-            Offset cur = 0;
+            Offset cur = offset[block_size*i];
             for(int j=block_size*i; j<end;++j){
                 offset[j] = cur;
                 cur += degree[j];
@@ -103,9 +108,12 @@ public:
         Offset *offset = count_offset(degree);
         set_index(offset, idx, nodelist);
 
-        for(auto iter = el.begin(); iter<el.end();++iter){
-            if(inv) nodelist[__sync_fetch_and_add(&offset[iter->second],1)] = iter->first;
-            else nodelist[__sync_fetch_and_add(&offset[iter->first],1)] = iter->second;
+        {
+            PHASE("csr.scatter");
+            for(auto iter = el.begin(); iter<el.end();++iter){
+                if(inv) nodelist[__sync_fetch_and_add(&offset[iter->second],1)] = iter->first;
+                else nodelist[__sync_fetch_and_add(&offset[iter->first],1)] = iter->second;
+            }
         }
 
         delete[] degree;
@@ -113,10 +121,10 @@ public:
     }
 
     void Release(){
-        if(out_index_ != nullptr) delete[] out_index_;
-        if(out_neighbors_ != nullptr) delete[] out_neighbors_;
-        if(in_index_ != nullptr) delete[] in_index_;
-        if(in_neighbors_ != nullptr) delete[] in_neighbors_;
+        numa_free(out_index_, num_nodes_+1);
+        numa_free(out_neighbors_, num_edges_);
+        numa_free(in_index_, num_nodes_+1);
+        numa_free(in_neighbors_, num_edges_);
     }
 
     CSRGraph(){
@@ -140,14 +148,29 @@ public:
         other.in_neighbors_ =  nullptr;  
     }
 
+    // 배열만 할당, index/neighbor는 호출하는 쪽에서 채움 (snapshot export)
+    CSRGraph(int64_t num_nodes, int64_t num_edges){
+        num_edges_ = num_edges;
+        num_nodes_ = num_nodes;
+
+        out_index_ =  numa_alloc<Node*>(num_nodes_+1);
+        out_neighbors_ =  numa_alloc<Node>(num_edges_);
+        in_index_ =  numa_alloc<Node*>(num_nodes_+1);
+        in_neighbors_ =  numa_alloc<Node>(num_edges_);
+        COUNT_BYTES("csr.index", 2*(num_nodes_+1)*sizeof(Node*));
+        COUNT_BYTES("csr.neighbors", 2*num_edges_*sizeof(Node));
+    }
+
     CSRGraph(std::vector<Edge> &el){
         num_edges_ = el.size();
         num_nodes_ = find_max_node(el)+1;
 
-        out_index_ =  new Node*[num_nodes_+1];
-        out_neighbors_ =  new Node[num_edges_];
-        in_index_ =  new Node*[num_nodes_+1];
-        in_neighbors_ =  new Node[num_edges_];
+        out_index_ =  numa_alloc<Node*>(num_nodes_+1);
+        out_neighbors_ =  numa_alloc<Node>(num_edges_);
+        in_index_ =  numa_alloc<Node*>(num_nodes_+1);
+        in_neighbors_ =  numa_alloc<Node>(num_edges_);
+        COUNT_BYTES("csr.index", 2*(num_nodes_+1)*sizeof(Node*));
+        COUNT_BYTES("csr.neighbors", 2*num_edges_*sizeof(Node));
 
         makeCSR(el, out_index_, out_neighbors_, false);
         makeCSR(el, in_index_, in_neighbors_, true);
@@ -0,0 +1,88 @@
+#ifndef PARTITION_H_
+#define PARTITION_H_
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <omp.h>
+
+/*
+Edge-balanced partition
+
+vertex 범위를 누적 degree 기준으로 잘라 part마다 비슷한 수의 edge를 갖도록 함
+degree가 part 하나 크기를 넘는 hub vertex는 범위 계산에서 빼고 hubs()로 따로 돌려줌
+-> 호출하는 쪽에서 hub의 edge를 thread들에 나눠 처리 (per-thread reduction)
+
+    edge_partition part(n, [&](int64_t v){ return g.in_degree(v);});
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(int p=0;p<part.num_parts();++p)
+        for(int64_t v=part.begin(p); v<part.end(p); ++v)
+            if(!part.is_hub(g.in_degree(v))) ...
+    for(auto v: part.hubs()) ...
+*/
+
+class edge_partition{
+    static const int64_t block_size = 1<<16;
+    static const int64_t min_hub_degree = 1<<10;
+
+    int num_parts_;
+    int64_t hub_threshold_;
+    std::vector<int64_t> bounds_;
+    std::vector<int64_t> hubs_;
+
+public:
+    template <typename DegreeF>
+    edge_partition(int64_t num_nodes, DegreeF degree, bool split_hubs = true, int parts_per_thread = 8){
+        num_parts_ = std::max<int64_t>(1, std::min<int64_t>(num_nodes, omp_get_max_threads()*parts_per_thread));
+
+        int64_t total = 0;
+        #pragma omp parallel for reduction(+:total)
+        for(int64_t v=0;v<num_nodes;++v) total += degree(v);
+        hub_threshold_ = split_hubs ? std::max<int64_t>(total/num_parts_, int64_t(min_hub_degree)) : INT64_MAX;
+
+        // vertex마다 weight = degree + 1 (hub는 1), blocked prefix sum
+        int64_t num_block = (num_nodes + block_size - 1) / block_size;
+        std::vector<int64_t> prefix(num_nodes+1);
+        std::vector<int64_t> block_sum(num_block+1, 0);
+        std::vector<std::vector<int64_t>> block_hubs(num_block);
+
+        #pragma omp parallel for
+        for(int64_t b=0;b<num_block;++b){
+            int64_t end = std::min((b+1)*block_size, num_nodes), sum = 0;
+            for(int64_t v=b*block_size;v<end;++v){
+                int64_t d = degree(v);
+                if(is_hub(d)) block_hubs[b].push_back(v), d = 0;
+                prefix[v] = sum;
+                sum += d + 1;
+            }
+            block_sum[b+1] = sum;
+        }
+
+        for(int64_t b=0;b<num_block;++b){
+            block_sum[b+1] += block_sum[b];
+            hubs_.insert(hubs_.end(), block_hubs[b].begin(), block_hubs[b].end());
+        }
+
+        #pragma omp parallel for
+        for(int64_t b=0;b<num_block;++b){
+            int64_t end = std::min((b+1)*block_size, num_nodes);
+            for(int64_t v=b*block_size;v<end;++v) prefix[v] += block_sum[b];
+        }
+        prefix[num_nodes] = block_sum[num_block];
+
+        bounds_.resize(num_parts_+1);
+        int64_t weight = prefix[num_nodes];
+        #pragma omp parallel for
+        for(int p=0;p<=num_parts_;++p)
+            bounds_[p] = std::lower_bound(prefix.begin(), prefix.end(), weight*p/num_parts_) - prefix.begin();
+        bounds_[num_parts_] = num_nodes;
+    }
+
+    int num_parts() const{ return num_parts_;}
+    int64_t begin(int p) const{ return bounds_[p];}
+    int64_t end(int p) const{ return bounds_[p+1];}
+    bool is_hub(int64_t degree) const{ return degree > hub_threshold_;}
+    const std::vector<int64_t>& hubs() const{ return hubs_;}
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef INSTRUMENT_H_
+#define INSTRUMENT_H_
+
+/*
+Phase timer / memory accounting
+
+-DINSTRUMENT      : phase별 wall time, 할당 byte 기록 (없으면 매크로가 모두 사라짐)
+-DINSTRUMENT_PERF : perf_event_open으로 cache miss, instruction 수도 기록
+
+phase는 parallel region 바깥에서 열고 닫는다 (snapshot export처럼 별도 thread에서 열어도 됨)
+perf counter는 inherit로 열리므로 counter를 연 뒤에 생성된 thread만 집계됨
+-> main 시작 시 parallel region(numa_init, OpenMP loop)보다 먼저 INSTRUMENT_INIT() 호출
+*/
+
+#ifdef INSTRUMENT
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#ifdef INSTRUMENT_PERF
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "timer.h"
+
+class instrument{
+public:
+    static const int NUM_COUNTER = 2;
+
+    struct phase_stat{
+        std::string name;
+        int64_t calls;
+        double seconds;
+        uint64_t counters[NUM_COUNTER];
+    };
+
+    struct alloc_stat{
+        std::string name;
+        int64_t count;
+        uint64_t bytes;
+    };
+
+    class scoped_phase{
+        const char *name_;
+        uint64_t begin_[NUM_COUNTER];
+        Timer t_;
+    public:
+        scoped_phase(const char *name) : name_(name){
+            instrument::get().read_counters(begin_);
+            t_.Start();
+        }
+        ~scoped_phase(){
+            t_.Stop();
+            uint64_t end[NUM_COUNTER];
+            instrument::get().read_counters(end);
+            for(int i=0;i<NUM_COUNTER;++i) end[i] -= begin_[i];
+            instrument::get().add_phase(name_, t_.Seconds(), end);
+        }
+    };
+
+private:
+    std::vector<phase_stat> phases_;
+    std::vector<alloc_stat> allocs_;
+    std::mutex mutex_;
+    int perf_fd_[NUM_COUNTER];
+
+    instrument(){
+        for(int i=0;i<NUM_COUNTER;++i) perf_fd_[i] = -1;
+#ifdef INSTRUMENT_PERF
+        const uint64_t config[NUM_COUNTER] = {PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_INSTRUCTIONS};
+        for(int i=0;i<NUM_COUNTER;++i){
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = config[i];
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            perf_fd_[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+        if(!has_counters()) fprintf(stderr, "instrument: perf_event_open failed, counters disabled\n");
+#endif
+    }
+
+    ~instrument(){
+#ifdef INSTRUMENT_PERF
+        for(int i=0;i<NUM_COUNTER;++i)
+            if(perf_fd_[i] != -1) close(perf_fd_[i]);
+#endif
+    }
+
+public:
+    static instrument& get(){
+        static instrument inst;
+        return inst;
+    }
+
+    bool has_counters() const{ return perf_fd_[0] != -1 && perf_fd_[1] != -1;}
+
+    void read_counters(uint64_t *val){
+        for(int i=0;i<NUM_COUNTER;++i){
+            val[i] = 0;
+#ifdef INSTRUMENT_PERF
+            if(perf_fd_[i] != -1 && read(perf_fd_[i], &val[i], sizeof(val[i])) != sizeof(val[i])) val[i] = 0;
+#endif
+        }
+    }
+
+    void add_phase(const char *name, double sec, const uint64_t *counters){
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(auto &p: phases_){
+            if(p.name == name){
+                ++p.calls;
+                p.seconds += sec;
+                for(int i=0;i<NUM_COUNTER;++i) p.counters[i] += counters[i];
+                return;
+            }
+        }
+        phase_stat p = {name, 1, sec, {counters[0], counters[1]}};
+        phases_.push_back(p);
+    }
+
+    void add_bytes(const char *name, uint64_t bytes){
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(auto &a: allocs_){
+            if(a.name == name){
+                ++a.count;
+                a.bytes += bytes;
+                return;
+            }
+        }
+        allocs_.push_back({name, 1, bytes});
+    }
+
+    void reset(){
+        std::lock_guard<std::mutex> lock(mutex_);
+        phases_.clear();
+        allocs_.clear();
+    }
+
+    // JSON 형식으로 출력
+    void report(FILE *out){
+        std::lock_guard<std::mutex> lock(mutex_);
+        fprintf(out, "{\"phases\": [");
+        for(size_t i=0;i<phases_.size();++i){
+            phase_stat &p = phases_[i];
+            fprintf(out, "%s\n  {\"name\": \"%s\", \"calls\": %ld, \"seconds\": %lf",
+                    i ? "," : "", p.name.c_str(), p.calls, p.seconds);
+            if(has_counters())
+                fprintf(out, ", \"cache_misses\": %lu, \"instructions\": %lu", p.counters[0], p.counters[1]);
+            fprintf(out, "}");
+        }
+        fprintf(out, "\n], \"allocations\": [");
+        for(size_t i=0;i<allocs_.size();++i){
+            alloc_stat &a = allocs_[i];
+            fprintf(out, "%s\n  {\"name\": \"%s\", \"count\": %ld, \"bytes\": %lu}",
+                    i ? "," : "", a.name.c_str(), a.count, a.bytes);
+        }
+        fprintf(out, "\n]}\n");
+    }
+};
+
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+
+// perf counter를 연다, OpenMP thread pool이 생기기 전에 호출
+#define INSTRUMENT_INIT() instrument::get()
+// 현재 scope가 끝날 때까지를 name phase로 기록
+#define PHASE(name) instrument::scoped_phase INSTRUMENT_CONCAT(phase_, __LINE__)(name)
+#define COUNT_BYTES(name, bytes) instrument::get().add_bytes(name, bytes)
+#define INSTRUMENT_REPORT(out) instrument::get().report(out)
+
+#else
+
+#define INSTRUMENT_INIT()
+#define PHASE(name)
+#define COUNT_BYTES(name, bytes)
+#define INSTRUMENT_REPORT(out)
+
+#endif
+
+#endif  // INSTRUMENT_H_
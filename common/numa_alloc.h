@@ -0,0 +1,214 @@
+#ifndef NUMA_ALLOC_H_
+#define NUMA_ALLOC_H_
+
+/*
+NUMA-aware allocation / thread pinning
+
+numa_init()으로 모드를 정함 (인자가 없으면 GRAPH_NUMA 환경변수 사용)
+  off         : 기존 동작, 처음 쓰는 thread의 node에 page가 잡힘
+  first_touch : 큰 array를 OpenMP static partition 순서로 병렬 first-touch
+                -> schedule(static) loop에서만 thread마다 자기 node의 page를 읽음
+                   edge_partition + schedule(dynamic, 1) loop(csr_pagerank, csr_scan, Chronos)는
+                   part를 읽는 thread가 매번 달라지므로 local이 보장되지 않음
+  interleave  : 모든 node에 page 단위로 interleave (process 전체 heap 포함)
+                -> dynamic/edge-balanced loop처럼 소유 thread가 고정되지 않을 때
+first_touch, interleave는 OpenMP thread를 CPU 하나씩에 pinning
+
+libnuma 없이 mbind/set_mempolicy syscall만 사용
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <new>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <omp.h>
+
+enum numa_mode{ NUMA_OFF, NUMA_FIRST_TOUCH, NUMA_INTERLEAVE };
+
+// 이보다 작은 array는 malloc 그대로 사용
+const size_t NUMA_MIN_BYTES = 1<<20;
+
+inline numa_mode& numa_policy(){
+    static numa_mode mode = NUMA_OFF;
+    return mode;
+}
+
+inline const char* numa_mode_name(numa_mode mode){
+    switch(mode){
+        case NUMA_FIRST_TOUCH: return "first_touch";
+        case NUMA_INTERLEAVE: return "interleave";
+        default: return "off";
+    }
+}
+
+inline numa_mode numa_parse_mode(const char *s){
+    if(s == nullptr) return NUMA_OFF;
+    if(strcmp(s, "first_touch") == 0) return NUMA_FIRST_TOUCH;
+    if(strcmp(s, "interleave") == 0) return NUMA_INTERLEAVE;
+    return NUMA_OFF;
+}
+
+// "0-3,8-11" 형식
+inline std::vector<int> numa_parse_list(const std::string &list){
+    std::vector<int> ids;
+    size_t pos = 0;
+    while(pos < list.size()){
+        size_t next = list.find(',', pos);
+        if(next == std::string::npos) next = list.size();
+        std::string range = list.substr(pos, next-pos);
+        size_t dash = range.find('-');
+        if(!range.empty()){
+            int lo = atoi(range.c_str());
+            int hi = dash == std::string::npos ? lo : atoi(range.c_str()+dash+1);
+            for(int i=lo;i<=hi;++i) ids.push_back(i);
+        }
+        pos = next+1;
+    }
+    return ids;
+}
+
+inline std::vector<int> numa_nodes(){
+    std::ifstream in("/sys/devices/system/node/online");
+    std::string list;
+    if(!(in>>list)) return std::vector<int>(1, 0);
+    return numa_parse_list(list);
+}
+
+inline std::vector<int> numa_node_cpus(int node){
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if(!(in>>list)) return std::vector<int>();
+    return numa_parse_list(list);
+}
+
+inline unsigned long numa_node_mask(const std::vector<int> &nodes){
+    unsigned long mask = 0;
+    for(int n: nodes) if(n < 64) mask |= 1UL<<n;
+    return mask;
+}
+
+inline void numa_pin_thread(int cpu){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+// set_mempolicy는 호출한 thread와 그 뒤에 생성되는 thread에만 적용됨
+inline bool numa_set_interleave(){
+    unsigned long mask = numa_node_mask(numa_nodes());
+    return syscall(__NR_set_mempolicy, MPOL_INTERLEAVE, &mask, sizeof(mask)*8) == 0;
+}
+
+// pinning 전 process affinity mask
+struct numa_affinity{
+    bool saved = false;
+    cpu_set_t mask;
+};
+
+inline numa_affinity& numa_process_affinity(){
+    static numa_affinity affinity;
+    return affinity;
+}
+
+// 새 thread는 만든 thread의 affinity를 물려받으므로 pinning된 master에서 만든 thread(std::async 등)는
+// 그 OpenMP team까지 master의 CPU 하나에 묶임 -> thread 시작 시 호출해 process mask로 되돌림
+inline void numa_unpin_thread(){
+    numa_affinity &affinity = numa_process_affinity();
+    if(affinity.saved) sched_setaffinity(0, sizeof(affinity.mask), &affinity.mask);
+}
+
+// thread i -> 허용된 CPU 중 i번째
+// CPU 번호가 socket을 번갈아 가는 machine도 있으므로 node별 cpulist 순서로 채움
+// -> 연속된 thread id가 같은 node에 모임
+inline void numa_pin_threads(){
+    static bool pinned = false;
+    if(pinned) return;
+    pinned = true;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    numa_process_affinity().mask = allowed;
+    numa_process_affinity().saved = true;
+    std::vector<int> cpus;
+    for(int node: numa_nodes()){
+        for(int c: numa_node_cpus(node)){
+            if(c >= 0 && c < CPU_SETSIZE && CPU_ISSET(c, &allowed)){
+                cpus.push_back(c);
+                CPU_CLR(c, &allowed);
+            }
+        }
+    }
+    // sysfs에 없는 CPU (node 정보를 읽지 못한 경우)는 번호 순서로 뒤에 붙임
+    for(int c=0;c<CPU_SETSIZE;++c) if(CPU_ISSET(c, &allowed)) cpus.push_back(c);
+    if(cpus.empty()) return;
+
+    #pragma omp parallel
+    {
+        numa_pin_thread(cpus[omp_get_thread_num() % cpus.size()]);
+        // 이미 만들어져 있던 pool thread는 master의 mempolicy를 물려받지 못하므로 각자 설정
+        if(numa_policy() == NUMA_INTERLEAVE) numa_set_interleave();
+    }
+}
+
+inline void numa_init(numa_mode mode){
+    numa_policy() = mode;
+    if(mode == NUMA_OFF) return;
+    // OpenMP pool이 생기기 전에 설정해야 pool thread가 interleave policy를 물려받음
+    if(mode == NUMA_INTERLEAVE && !numa_set_interleave())
+        fprintf(stderr, "numa: set_mempolicy failed\n");
+    numa_pin_threads();
+}
+
+inline void numa_init(){
+    numa_init(numa_parse_mode(getenv("GRAPH_NUMA")));
+}
+
+// n개짜리 array 할당, 현재 모드에 맞게 page 배치 (내용은 초기화되지 않음)
+template <typename T>
+T* numa_alloc(size_t n){
+    size_t bytes = n*sizeof(T);
+    if(bytes < NUMA_MIN_BYTES){
+        void *p = malloc(std::max<size_t>(bytes, 1));
+        if(p == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void *p = mmap(nullptr, bytes, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(p == MAP_FAILED) throw std::bad_alloc();
+
+    numa_mode mode = numa_policy();
+    if(mode == NUMA_INTERLEAVE){
+        unsigned long mask = numa_node_mask(numa_nodes());
+        syscall(__NR_mbind, p, bytes, MPOL_INTERLEAVE, &mask, sizeof(mask)*8, 0);
+    }else if(mode == NUMA_FIRST_TOUCH){
+        // element 기준 static partition과 같은 순서로 page를 touch
+        char *c = static_cast<char*>(p);
+        const int64_t page_size = sysconf(_SC_PAGESIZE);
+        const int64_t num_pages = (bytes + page_size - 1) / page_size;
+        #pragma omp parallel for schedule(static)
+        for(int64_t pg=0;pg<num_pages;++pg) c[pg*page_size] = 0;
+    }
+    return static_cast<T*>(p);
+}
+
+template <typename T>
+void numa_free(T *p, size_t n){
+    if(p == nullptr) return;
+    size_t bytes = n*sizeof(T);
+    if(bytes < NUMA_MIN_BYTES) free(p);
+    else munmap(p, bytes);
+}
+
+#endif
@@ -1,5 +1,5 @@
-#ifndef CSRGRAPH_H_
-#define CSRGRAPH_H_
+#ifndef LLAMA_CSRGRAPH_H_
+#define LLAMA_CSRGRAPH_H_
 
 #include <vector>
 #include <algorithm>
@@ -7,6 +7,8 @@
 #include <cstdio>
 
 #include "snapshot.h"
+#include "../common/instrument.h"
+#include "../common/numa_alloc.h"
 
 typedef int64_t Offset;
 
@@ -31,21 +33,24 @@ class csrgraph{
         return max_node;
     }
 
-    size_t find_current_num_node(std::vector<Edge> &el){
+    size_t find_current_num_node(std::vector<Edge> &el, bool inv){
         size_t cnt = 0;
         bool *exist = new bool[num_node_];
         std::fill(exist, exist+num_node_,false);
         #pragma omp parallel for reduction(+:cnt)
         for(auto iter = el.begin(); iter<el.end(); ++iter){
-            if(!exist[iter->first]){
+            Node n = inv ? iter->second : iter->first;
+            if(!exist[n]){
                 cnt++;
-                exist[iter->first] = true;
+                exist[n] = true;
             }
         }
+        delete[] exist;
         return cnt;
     }
 
     Node* count_degree(std::vector<Edge> &el, bool inv, bool deltamap){
+        PHASE("llama.degree_count");
         Node* degree = new Node[num_node_];
         #pragma omp parallel for
         for(int i=0;i<num_node_;++i) degree[i] = 0;
@@ -64,6 +69,7 @@ class csrgraph{
     }
 
     Offset* count_offset(Node* degree){
+        PHASE("llama.prefix_sum");
         size_t block_size = 1<<20;
         size_t num_block = (num_node_ + (block_size-1))/block_size;
 
@@ -85,7 +91,7 @@ class csrgraph{
         #pragma omp parallel for
         for(int i=0;i<num_block;++i){
             int end = std::min((i+1)*block_size, num_node_);
-            Offset cur = 0;
+            Offset cur = offset[block_size*i];
             for(int j=block_size*i; j<end;++j){
                 offset[j] = cur;
                 cur += degree[j];
@@ -107,10 +113,13 @@ class csrgraph{
         
         set_index(offset, idx, nodelist);
 
-        #pragma omp parallel for
-        for(auto iter = el.begin(); iter<el.end();++iter){
-            if(inv) nodelist[__sync_fetch_and_add(&offset[iter->second],1)] = iter->first;
-            else nodelist[__sync_fetch_and_add(&offset[iter->first],1)] = iter->second;
+        {
+            PHASE("llama.scatter");
+            #pragma omp parallel for
+            for(auto iter = el.begin(); iter<el.end();++iter){
+                if(inv) nodelist[__sync_fetch_and_add(&offset[iter->second],1)] = iter->first;
+                else nodelist[__sync_fetch_and_add(&offset[iter->first],1)] = iter->second;
+            }
         }
 
         delete[] degree;
@@ -124,10 +133,13 @@ class csrgraph{
         
         set_index(offset, idx, nodelist);
 
-        #pragma omp parallel for
-        for(auto iter = el.begin(); iter<el.end();++iter){
-            if(inv) nodelist[__sync_fetch_and_add(&offset[iter->second],1)] = iter->first;
-            else nodelist[__sync_fetch_and_add(&offset[iter->first],1)] = iter->second;
+        {
+            PHASE("llama.scatter");
+            #pragma omp parallel for
+            for(auto iter = el.begin(); iter<el.end();++iter){
+                if(inv) nodelist[__sync_fetch_and_add(&offset[iter->second],1)] = iter->first;
+                else nodelist[__sync_fetch_and_add(&offset[iter->first],1)] = iter->second;
+            }
         }
 
         delete[] degree;
@@ -140,7 +152,7 @@ public:
         num_node_ =  find_max_node(el)+1;
 
         out_idx_ =  new Node*[num_node_+1];
-        out_nodelist_ =  new Node[nodelist_size_];
+        out_nodelist_ =  numa_alloc<Node>(nodelist_size_);
         in_idx_ =  new Node*[num_node_+1];
         in_nodelist_ =  new Node[nodelist_size_];
 
@@ -150,13 +162,14 @@ public:
 
     csrgraph(std::vector<Edge> &el, std::vector<snapshot<Node>*> &snapshots){
         num_node_ =  find_max_node(el)+1;
-        size_t cur_num_node = find_current_num_node(el);
-        nodelist_size_ = el.size() + 2*cur_num_node;
+        // 각 vertex의 fragment 끝에 (snapshot id, offset) 2칸 추가
+        nodelist_size_ = el.size() + 2*find_current_num_node(el, false);
+        size_t in_nodelist_size = el.size() + 2*find_current_num_node(el, true);
 
         out_idx_ =  new Node*[num_node_+1];
-        out_nodelist_ =  new Node[nodelist_size_];
+        out_nodelist_ =  numa_alloc<Node>(nodelist_size_);
         in_idx_ =  new Node*[num_node_+1];
-        in_nodelist_ =  new Node[nodelist_size_];
+        in_nodelist_ =  new Node[in_nodelist_size];
 
         makeCSR(el, out_idx_, out_nodelist_, false, snapshots);
         makeCSR(el, in_idx_, in_nodelist_, true, snapshots);
@@ -165,7 +178,7 @@ public:
 
     ~csrgraph(){
         if(out_idx_ != nullptr) delete[] out_idx_;
-        if(out_nodelist_ != nullptr) delete[] out_nodelist_;
+        numa_free(out_nodelist_, nodelist_size_);
         if(in_idx_ != nullptr) delete[] in_idx_;
         if(in_nodelist_ != nullptr) delete[] in_nodelist_;
     };
@@ -8,6 +8,7 @@
 #include <iostream>
 
 #include "csrgraph.h"
+#include "../common/timer.h"
 #include "snapshot.h"
 #include "page.h"
 #include "vertex_record.h"
@@ -17,64 +18,161 @@ using namespace std;
 #define PG_IDX(x) ((x)>>M)
 #define VT_IDX(x) ((x) & (PAGE_SIZE - 1))
 
+template <typename Node>
+vertex_record* find_record(snapshot<Node> *sn, Node n){
+    vector<page*> &table = sn->indirection_table;
+    if(size_t(PG_IDX(n)) >= table.size() || table[PG_IDX(n)] == nullptr) return nullptr;
+    return &(*table[PG_IDX(n)])[VT_IDX(n)];
+}
+
+// snapshot snap_id 시점에서 n의 fragment 체인을 최신 것부터 방문
+// visit(fragment가 만들어진 snapshot id, fragment 시작, 길이)
+template <typename Node, typename F>
+void for_each_fragment(snapshot<Node>* const *snapshots, size_t snap_id, Node n, F visit){
+    vertex_record *rec = find_record(snapshots[snap_id], n);
+    if(rec == nullptr) return;
+    int64_t s = rec->snapshot_id();
+    size_t offset = rec->offset(), length = rec->fragment_length();
+    while(s != -1){
+        Node *fragment = snapshots[s]->edge_table + offset;
+        visit(s, fragment, length);
+        if(s == 0) break;   // 첫 snapshot에는 continuation record가 없음
+        offset = fragment[length+1];
+        s = fragment[length];
+        if(s != -1) length = find_record(snapshots[s], n)->fragment_length();
+    }
+}
+
+// snapshot 0..snap_id pointer의 복사본
+// snapshot은 만들어진 뒤 바뀌지 않으므로 add_snapshot과 동시에 읽어도 됨 (graph_manager보다 오래 쓰면 안 됨)
+template <typename Node>
+class snapshot_view{
+    vector<snapshot<Node>*> snapshots;
+public:
+    snapshot_view(vector<snapshot<Node>*> &sn, size_t snap_id) : snapshots(sn.begin(), sn.begin()+snap_id+1){}
+
+    size_t snap_id() const{ return snapshots.size()-1;}
+    int64_t num_nodes(size_t s) const{ return snapshots[s]->num_nodes;}
+    int64_t num_nodes() const{ return num_nodes(snap_id());}
+
+    template <typename F>
+    void fragments(Node n, F visit) const{ for_each_fragment(snapshots.data(), snap_id(), n, visit);}
+
+    template <typename F>
+    void out_neigh(Node n, F visit) const{
+        fragments(n, [&visit](int64_t, Node *begin, size_t length){
+            for(size_t i=0;i<length;++i) visit(begin[i]);
+        });
+    }
+};
+
 template <typename Node>
 class graph_manager{
     typedef pair<Node,Node> Edge;
 
     vector<snapshot<Node>*> snapshots;
     vector<page*> indir_table;
+    int64_t num_nodes_;
+    double csr_build_time_;     // init_graph/add_snapshot 중 csrgraph 생성에 쓴 시간
+    bool verbose;
 
 public:
-    graph_manager(){}
+    graph_manager(bool v = true) : num_nodes_(0), csr_build_time_(0), verbose(v){}
 
     ~graph_manager(){
+        // copy-on-write 이후 page는 여러 snapshot이 공유
+        vector<page*> pages(indir_table);
         for(auto &sn: snapshots)
-            delete sn;
-        for(auto &pg: indir_table)
+            pages.insert(pages.end(), sn->indirection_table.begin(), sn->indirection_table.end());
+        sort(pages.begin(), pages.end());
+        pages.erase(unique(pages.begin(), pages.end()), pages.end());
+        for(auto &pg: pages)
             if(pg != nullptr) delete pg;
+        for(auto &sn: snapshots)
+            delete sn;
     }
 
     void init_graph(vector<Edge> &el){
-        cout<<"init\n";
+        PHASE("llama.init_graph");
+        if(verbose) cout<<"init\n";
+        Timer t;
+        t.Start();
         csrgraph<Node> g(el);
-        cout<<"make graph\n";
+        t.Stop();
+        csr_build_time_ += t.Seconds();
+        if(verbose) cout<<"make graph\n";
         int num_pages = (g.num_nodes() + PAGE_SIZE - 1) / PAGE_SIZE;
 
         indir_table.reserve(num_pages);
         for(int i=0; i<num_pages; ++i)
             indir_table.push_back(new page(snapshots.size()));
-        cout<<"make indir table\n";
+        if(verbose) cout<<"make indir table\n";
 
-        for(Node n=0; n<g.num_nodes();++n)
-            if(g.out_degree(n) > 0)
-                (*indir_table[PG_IDX(n)])[VT_IDX(n)].set_record(snapshots.size(), g.out_offset(n), g.out_degree(n));
-        cout<<"indir init\n";
+        {
+            PHASE("llama.indir_init");
+            for(Node n=0; n<g.num_nodes();++n)
+                if(g.out_degree(n) > 0)
+                    (*indir_table[PG_IDX(n)])[VT_IDX(n)].set_record(snapshots.size(), g.out_offset(n), g.out_degree(n));
+        }
+        if(verbose) cout<<"indir init\n";
 
-        snapshots.push_back(new snapshot<Node>(indir_table, g.edge_table()));
-        cout<<"pushback\n";
+        num_nodes_ = g.num_nodes();
+        COUNT_BYTES("llama.edge_table", g.nodelist_size()*sizeof(Node));
+        snapshots.push_back(new snapshot<Node>(indir_table, g.nodelist_size(), g.edge_table(), num_nodes_));
+        if(verbose) cout<<"pushback\n";
     }
     
     void add_snapshot(vector<Edge> &el){
+        PHASE("llama.add_snapshot");
+        Timer t;
+        t.Start();
         csrgraph<Node> g(el, snapshots);
+        t.Stop();
+        csr_build_time_ += t.Seconds();
         int num_pages = (g.num_nodes() + PAGE_SIZE - 1) / PAGE_SIZE;
         if(num_pages > indir_table.size()) 
             indir_table.resize(num_pages, nullptr);
 
-        for(Node n=0; n<g.num_nodes();++n){
-            if(g.out_degree(n) > 0){
-                if(indir_table[PG_IDX(n)] == nullptr)
-                    indir_table[PG_IDX(n)] = new page(snapshots.size());
-                else if((*indir_table[PG_IDX(n)]).id != snapshots.size()) 
-                    indir_table[PG_IDX(n)] = new page(*indir_table[PG_IDX(n)],snapshots.size());
-                vertex_record &cur_vertex = (*indir_table[PG_IDX(n)])[VT_IDX(n)];
-                g.set_out_record(g.out_offset(n)+g.out_degree(n)-2, cur_vertex.snapshot_id(), cur_vertex.offset());
-                cur_vertex.set_record(snapshots.size(), g.out_offset(n), g.out_degree(n)-2);
+        {
+            PHASE("llama.page_cow");
+            for(Node n=0; n<g.num_nodes();++n){
+                if(g.out_degree(n) > 0){
+                    if(indir_table[PG_IDX(n)] == nullptr)
+                        indir_table[PG_IDX(n)] = new page(snapshots.size());
+                    else if((*indir_table[PG_IDX(n)]).id != snapshots.size()) 
+                        indir_table[PG_IDX(n)] = new page(*indir_table[PG_IDX(n)],snapshots.size());
+                    vertex_record &cur_vertex = (*indir_table[PG_IDX(n)])[VT_IDX(n)];
+                    g.set_out_record(g.out_offset(n)+g.out_degree(n)-2, cur_vertex.snapshot_id(), cur_vertex.offset());
+                    cur_vertex.set_record(snapshots.size(), g.out_offset(n), g.out_degree(n)-2);
+                }
             }
         }
 
-        snapshots.push_back(new snapshot<Node>(indir_table, g.edge_table()));
+        num_nodes_ = max(num_nodes_, g.num_nodes());
+        COUNT_BYTES("llama.edge_table", g.nodelist_size()*sizeof(Node));
+        snapshots.push_back(new snapshot<Node>(indir_table, g.nodelist_size(), g.edge_table(), num_nodes_));
     }
 
+    size_t num_snapshots(){ return snapshots.size();}
+    double csr_build_seconds(){ return csr_build_time_;}
+    int64_t num_nodes(size_t snap_id){ return snapshots[snap_id]->num_nodes;}
+
+    // fragment 체인을 따라가며 snapshot snap_id 시점의 out-neighbor 방문
+    template <typename F>
+    void out_neigh(size_t snap_id, Node n, F visit){
+        for_each_fragment(snapshots.data(), snap_id, n, [&visit](int64_t, Node *begin, size_t length){
+            for(size_t i=0;i<length;++i) visit(begin[i]);
+        });
+    }
+
+    int64_t out_degree(size_t snap_id, Node n){
+        int64_t degree = 0;
+        for_each_fragment(snapshots.data(), snap_id, n, [&degree](int64_t, Node*, size_t length){ degree += length;});
+        return degree;
+    }
+
+    snapshot_view<Node> view(size_t snap_id){ return snapshot_view<Node>(snapshots, snap_id);}
+
     void print_graph(){
         printf("==SNAPSHOT %ld==\n", snapshots.size());
         for(int i=0; i < indir_table.size();++i){
@@ -6,6 +6,8 @@ typedef pair<Node,Node> Edge;
 #define CHUNK_SIZE 1<<10
 
 int main(int argc, char **argv){
+    INSTRUMENT_INIT();
+    numa_init();
     graph_manager<Node> manager;
     freopen(argv[1],"rt",stdin);
     int ret = 0;
@@ -13,9 +15,13 @@ int main(int argc, char **argv){
         //load file
         vector<Edge> el;
         int u,v,cnt = 0;
-        while((ret = scanf("%d %d",&u,&v)) !=-1 && cnt++ < CHUNK_SIZE) el.push_back({u,v});
+        {
+            PHASE("parse");
+            while((ret = scanf("%d %d",&u,&v)) !=-1 && cnt++ < CHUNK_SIZE) el.push_back({u,v});
+        }
         if(snap_id == 0) manager.init_graph(el);
         else manager.add_snapshot(el);
         manager.print_graph();
     }
+    INSTRUMENT_REPORT(stderr);
 }
\ No newline at end of file
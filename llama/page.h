@@ -2,6 +2,7 @@
 #define PAGE_H_
 
 #include "vertex_record.h"
+#include "../common/instrument.h"
 
 const int M = 1;
 const int PAGE_SIZE = 1 << M;
@@ -9,7 +10,10 @@ const int PAGE_SIZE = 1 << M;
 struct page{
     int id;
     vertex_record* vertices;
-    page(int i) : id(i) { vertices = new vertex_record[PAGE_SIZE];}
+    page(int i) : id(i) { 
+        vertices = new vertex_record[PAGE_SIZE];
+        COUNT_BYTES("llama.pages", sizeof(page) + PAGE_SIZE*sizeof(vertex_record));
+    }
     page(page &other, int i) : page(i){ 
         for(int i=0;i<PAGE_SIZE;++i) 
             vertices[i] = other[i]; 
@@ -2,18 +2,19 @@
 #define SNAPSHOT_H_
 
 #include <vector>
+#include <cstdint>
 #include "page.h"
+#include "../common/numa_alloc.h"
 
 template <typename Node>
 struct snapshot{
     std::vector<page*> indirection_table;
+    size_t edge_table_size;
     Node* edge_table;
-    snapshot(std::vector<page*> &i_t, Node* e_t) : edge_table(e_t){
-        int num_pages = i_t.size();
-        indirection_table.reserve(num_pages);
-        for(int i=0;i<num_pages;++i)
-            indirection_table[i] = i_t[i];
-    }
+    int64_t num_nodes;
+    snapshot(std::vector<page*> &i_t, size_t e_s, Node* e_t, int64_t n) : 
+        indirection_table(i_t), edge_table_size(e_s), edge_table(e_t), num_nodes(n){}
+    ~snapshot(){ numa_free(edge_table, edge_table_size);}
 }; 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,167 @@
+#ifndef SNAPSHOT_EXPORT_H_
+#define SNAPSHOT_EXPORT_H_
+
+#include <vector>
+#include <algorithm>
+#include <future>
+#include <cstdint>
+#include <stdexcept>
+
+#include "graph_manager.h"
+#include "../chronos/csrgraph.h"
+#include "../chronos/chronos.h"
+
+/*
+LLAMA snapshot -> flat array
+
+flatten_snapshot : snapshot 하나를 out/in adjacency를 모두 가진 CSRGraph로
+export_chronos   : snapshot 범위 [first, view의 snapshot]를 Chronos bitmap edge array로
+*_async          : 호출 시점의 snapshot_view를 잡고 별도 thread에서 실행 -> add_snapshot 계속 가능
+                   (NUMA pinning 중이면 export thread는 process 전체 CPU로 되돌린 뒤 실행)
+*/
+
+// out-neighbor 목록으로부터 in-adjacency 구성 (in-neighbor는 정렬됨)
+template <typename Node>
+void make_in_adjacency(CSRGraph<Node> &g){
+    int64_t n = g.num_nodes();
+    Node *degree = new Node[n];
+    #pragma omp parallel for
+    for(int64_t v=0;v<n;++v) degree[v] = 0;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int64_t u=0;u<n;++u)
+        for(const auto &v: g.out_neigh(u)) __sync_fetch_and_add(&degree[v], 1);
+
+    Offset *offset = g.count_offset(degree);
+    g.set_index(offset, g.in_index_, g.in_neighbors_);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int64_t u=0;u<n;++u)
+        for(const auto &v: g.out_neigh(u)) g.in_neighbors_[__sync_fetch_and_add(&offset[v], 1)] = u;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int64_t v=0;v<n;++v) std::sort(g.in_index_[v], g.in_index_[v+1]);
+
+    delete[] degree;
+    delete[] offset;
+}
+
+// pass 1 : fragment 길이로 degree 계산, pass 2 : fragment를 offset 위치로 복사
+template <typename Node>
+CSRGraph<Node> flatten_snapshot(const snapshot_view<Node> &view){
+    PHASE("export.flatten");
+    int64_t n = view.num_nodes(), m = 0;
+    Node *degree = new Node[n];
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:m)
+    for(int64_t u=0;u<n;++u){
+        Node d = 0;
+        view.fragments(u, [&d](int64_t, Node*, size_t length){ d += length;});
+        degree[u] = d;
+        m += d;
+    }
+
+    CSRGraph<Node> g(n, m);
+    Offset *offset = g.count_offset(degree);
+    g.set_index(offset, g.out_index_, g.out_neighbors_);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int64_t u=0;u<n;++u){
+        Node *dst = g.out_index_[u];
+        view.fragments(u, [&dst](int64_t, Node *begin, size_t length){
+            dst = std::copy(begin, begin+length, dst);
+        });
+    }
+    delete[] degree;
+    delete[] offset;
+
+    make_in_adjacency(g);
+    return g;
+}
+
+// LLAMA는 edge 추가만 하므로 snapshot t의 fragment에 있는 edge는 t 이후 모든 snapshot에 존재
+// -> view 시점의 체인만 한 번 따라가면 bitmap을 만들 수 있음
+template <typename Node>
+chronos_graph export_chronos(const snapshot_view<Node> &view, size_t first){
+    PHASE("export.chronos");
+    size_t last = view.snap_id();
+    if(first > last || last - first >= 32)
+        throw std::out_of_range("export_chronos: bitmap holds at most 32 snapshots");
+    std::vector<int64_t> num_nodes;
+    for(size_t s=first;s<=last;++s) num_nodes.push_back(view.num_nodes(s));
+    chronos_graph cg(num_nodes);
+    const int num_sn = cg.num_sn;
+    const uint64_t all = (uint64_t(1)<<num_sn) - 1;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int u=0;u<cg.max_v;++u){
+        std::vector<edge> &arr = cg.edge_array_out[u];
+        view.fragments(u, [&](int64_t t, Node *begin, size_t length){
+            int start = t > (int64_t)first ? t - first : 0;
+            int32_t bitmap = all & ~((uint64_t(1)<<start) - 1);
+            for(size_t i=0;i<length;++i){
+                arr.push_back(edge(begin[i]));
+                arr.back().bitmap = bitmap;
+            }
+        });
+        std::sort(arr.begin(), arr.end(), [](const edge &a, const edge &b){ return a.target < b.target;});
+        size_t k = 0;
+        for(size_t i=0;i<arr.size();++i){
+            if(k > 0 && arr[k-1].target == arr[i].target) arr[k-1].bitmap |= arr[i].bitmap;
+            else arr[k++] = arr[i];
+        }
+        arr.erase(arr.begin()+k, arr.end());
+    }
+
+    // in edge array : out edge array의 transpose
+    std::vector<int64_t> in_degree(cg.max_v, 0);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int u=0;u<cg.max_v;++u)
+        for(auto &e: cg.edge_array_out[u]) __sync_fetch_and_add(&in_degree[e.target], 1);
+
+    #pragma omp parallel for
+    for(int v=0;v<cg.max_v;++v) cg.edge_array_in[v].reserve(in_degree[v]);
+
+    std::vector<int64_t> offset(cg.max_v+1, 0);
+    for(int v=0;v<cg.max_v;++v) offset[v+1] = offset[v] + in_degree[v];
+    std::vector<edge> transposed(offset[cg.max_v], edge(0));
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int u=0;u<cg.max_v;++u){
+        for(auto &e: cg.edge_array_out[u]){
+            edge &dst = transposed[__sync_fetch_and_add(&offset[e.target], 1)];
+            dst.target = u;
+            dst.bitmap = e.bitmap;
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int v=0;v<cg.max_v;++v){
+        auto end = transposed.begin() + offset[v];
+        cg.edge_array_in[v].assign(end - in_degree[v], end);
+        std::sort(cg.edge_array_in[v].begin(), cg.edge_array_in[v].end(),
+            [](const edge &a, const edge &b){ return a.target < b.target;});
+    }
+
+    cg.make_vertex_array();
+    COUNT_BYTES("chronos.edge_array", cg.edge_array_bytes());
+    return cg;
+}
+
+template <typename Node>
+std::future<CSRGraph<Node>> flatten_snapshot_async(graph_manager<Node> &manager, size_t snap_id){
+    snapshot_view<Node> view = manager.view(snap_id);
+    return std::async(std::launch::async, [view](){
+        numa_unpin_thread();
+        return flatten_snapshot(view);
+    });
+}
+
+template <typename Node>
+std::future<chronos_graph> export_chronos_async(graph_manager<Node> &manager, size_t first, size_t last){
+    snapshot_view<Node> view = manager.view(last);
+    return std::async(std::launch::async, [view, first](){
+        numa_unpin_thread();
+        return export_chronos(view, first);
+    });
+}
+
+#endif
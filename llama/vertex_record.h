@@ -21,6 +21,7 @@ public:
 
     int64_t snapshot_id(){return snapshot_id_;}
     size_t offset(){return offset_;}
+    size_t fragment_length(){return fragment_length_;}
     void printrecord(){
         printf("id: %ld | offset: %ld | fragment length: %ld\n", snapshot_id_, offset_, fragment_length_);
     }